@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <thread>
+
+namespace common {
+
+    // Exponential backoff with "equal jitter": every delay is half the current step
+    // plus a random share of the other half, so replicas that lost the same
+    // dependency at the same moment don't reconnect in lockstep.
+    class Backoff {
+    public:
+        explicit Backoff(std::chrono::milliseconds initial = std::chrono::milliseconds(100),
+                         std::chrono::milliseconds max = std::chrono::seconds(10),
+                         double multiplier = 2.0)
+            : initial_(initial), max_(max), multiplier_(multiplier), current_(initial),
+              rng_(std::random_device{}()) {}
+
+        std::chrono::milliseconds next_delay() {
+            auto half = current_.count() / 2;
+            std::uniform_int_distribution<long long> jitter(0, half);
+            std::chrono::milliseconds delay(current_.count() - half + jitter(rng_));
+
+            auto grown = static_cast<long long>(current_.count() * multiplier_);
+            current_ = std::min(std::chrono::milliseconds(grown), max_);
+            ++attempts_;
+            return delay;
+        }
+
+        // Sleeps in short slices so a cancelled wait returns promptly; false if cancelled.
+        bool sleep(const std::function<bool()>& cancelled = nullptr) {
+            auto until = std::chrono::steady_clock::now() + next_delay();
+            while (true) {
+                if (cancelled && cancelled()) return false;
+                auto now = std::chrono::steady_clock::now();
+                if (now >= until) return true;
+                std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                    until - now, std::chrono::milliseconds(50)));
+            }
+        }
+
+        void reset() {
+            current_ = initial_;
+            attempts_ = 0;
+        }
+
+        int attempts() const {
+            return attempts_;
+        }
+
+    private:
+        std::chrono::milliseconds initial_;
+        std::chrono::milliseconds max_;
+        double multiplier_;
+        std::chrono::milliseconds current_;
+        int attempts_ = 0;
+        std::mt19937 rng_;
+    };
+
+} // namespace common
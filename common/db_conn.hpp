@@ -6,6 +6,8 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <functional>
+#include "common/backoff.hpp"
 
 namespace common {
 
@@ -26,17 +28,26 @@ namespace common {
             return nullptr;
         }
 
-        void wait_for_connection() {
+        // false if `cancelled` fired before a connection could be made
+        bool wait_for_connection(const std::function<bool()>& cancelled = nullptr) {
+            auto started = std::chrono::steady_clock::now();
+            Backoff backoff;
             while (true) {
                 try {
                     pqxx::connection C(connection_string_);
                     if (C.is_open()) {
-                        std::cout << "[DB Info] Successfully connected to database." << std::endl;
-                        break;
+                        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - started);
+                        std::cout << "[DB Info] Successfully connected to database in " << elapsed.count()
+                                  << " ms (" << backoff.attempts() << " retries)." << std::endl;
+                        return true;
                     }
                 } catch (const std::exception& e) {
                     std::cerr << "[DB Warning] Waiting for DB... (" << e.what() << ")" << std::endl;
-                    std::this_thread::sleep_for(std::chrono::seconds(2));
+                }
+                if (!backoff.sleep(cancelled)) {
+                    std::cerr << "[DB Warning] Gave up waiting for DB." << std::endl;
+                    return false;
                 }
             }
         }
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <initializer_list>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <nlohmann/json.hpp>
+#include "crow.h"
+
+namespace common {
+
+    // Startup readiness: /health/ready turns green once the DB and every relay/consumer
+    // have connected for the first time and stays green afterwards. Later outages of
+    // either dependency are ridden out by the workers' backoff instead of pulling all
+    // replicas out of rotation at once; the HTTP paths only need Postgres anyway.
+    class Readiness {
+    public:
+        Readiness(std::initializer_list<std::string> components)
+            : started_(std::chrono::steady_clock::now()) {
+            for (const auto& name : components) {
+                components_[name] = false;
+            }
+        }
+
+        void set_ready(const std::string& component) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (components_[component]) return;
+            components_[component] = true;
+
+            std::cout << "[Startup] " << component << " ready after " << elapsed_ms() << " ms" << std::endl;
+            if (all_ready()) {
+                std::cout << "[Startup] Service ready after " << elapsed_ms() << " ms" << std::endl;
+            }
+        }
+
+        bool is_ready() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return all_ready();
+        }
+
+        nlohmann::json to_json() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            nlohmann::json j;
+            j["ready"] = all_ready();
+            j["components"] = components_;
+            return j;
+        }
+
+    private:
+        bool all_ready() const {
+            for (const auto& [name, ready] : components_) {
+                if (!ready) return false;
+            }
+            return true;
+        }
+
+        long long elapsed_ms() const {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - started_).count();
+        }
+
+        std::chrono::steady_clock::time_point started_;
+        mutable std::mutex mutex_;
+        std::map<std::string, bool> components_;
+    };
+
+    // GET /health/live answers while the process is up, GET /health/ready reflects Readiness
+    template <typename App>
+    void add_health_routes(App& app, Readiness& readiness) {
+        CROW_ROUTE(app, "/health/live")([] {
+            return crow::response(200, "OK");
+        });
+
+        CROW_ROUTE(app, "/health/ready")([&readiness] {
+            auto status = readiness.to_json();
+            return crow::response(status["ready"].get<bool>() ? 200 : 503, status.dump());
+        });
+    }
+
+} // namespace common
@@ -0,0 +1,12 @@
+#pragma once
+
+namespace common {
+
+    // Outcome of one relay step: an outbox row stays pending until the broker has accepted it.
+    enum class OutboxResult {
+        Empty,
+        Published,
+        Failed
+    };
+
+} // namespace common
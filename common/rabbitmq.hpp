@@ -5,6 +5,9 @@
 #include <iostream>
 #include <thread>
 #include <optional>
+#include <chrono>
+#include <functional>
+#include "common/backoff.hpp"
 
 namespace common {
 
@@ -13,7 +16,11 @@ public:
 	RabbitMQ(const std::string& host, const std::string& queue_name)
     	: host_(host), queue_name_(queue_name) {}
 
-	void connect() {
+	// false if `cancelled` fired before a channel could be opened
+	bool connect(const std::function<bool()>& cancelled = nullptr) {
+		auto started = std::chrono::steady_clock::now();
+		Backoff backoff;
+    	consumer_tag_.clear();
     	while (true) {
         	try {
             	std::string uri = "amqp://user:password@" + host_ + ":5672";
@@ -23,47 +30,100 @@ public:
 
             	if (channel_) {
                 	channel_->DeclareQueue(queue_name_, false, true, false, false);
-                	std::cout << "[RabbitMQ] Connected to queue: " << queue_name_ << std::endl;
-                	break;
+                	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                		std::chrono::steady_clock::now() - started);
+                	std::cout << "[RabbitMQ] Connected to queue: " << queue_name_ << " in " << elapsed.count()
+                	          << " ms (" << backoff.attempts() << " retries)" << std::endl;
+                	return true;
    		    	}
     	    } catch (const std::exception& e) {
     	        std::cerr << "[RabbitMQ] Connection failed: " << e.what() << ". Retrying..." << std::endl;
-    	        std::this_thread::sleep_for(std::chrono::seconds(3));
+    	        channel_.reset();
+    	    }
+    	    if (!backoff.sleep(cancelled)) {
+    	        std::cerr << "[RabbitMQ] Gave up connecting to queue: " << queue_name_ << std::endl;
+    	        return false;
     	    }
     	}
 	}
 
-	void publish(const std::string& message) {
-	    if (!channel_) return;
+	// false once a channel error has been seen; the owner is expected to connect() again
+	bool is_connected() const {
+	    return channel_ != nullptr;
+	}
+
+	bool publish(const std::string& message) {
+	    if (!channel_) return false;
 	    try {
 	        auto msg = AmqpClient::BasicMessage::Create(message);
 	        channel_->BasicPublish("", queue_name_, msg);
+	        return true;
 	    } catch (const std::exception& e) {
 	        std::cerr << "[RabbitMQ] Publish error: " << e.what() << std::endl;
+	        channel_.reset();
+	        return false;
 	    }
 	}
 
 	void start_consume() {
     	if (!channel_) return;
     	try {
-        	consumer_tag_ = channel_->BasicConsume(queue_name_, "", true, true, false, 1);
+        	consumer_tag_ = channel_->BasicConsume(queue_name_, "", true, false, false, 1);
     	} catch (const std::exception& e) {
         	std::cerr << "[RabbitMQ] Start consume error: " << e.what() << std::endl;
+        	channel_.reset();
    		}
 	}
 
-	std::optional<std::string> consume_message(int timeout_ms = 100) {
-    	if (!channel_ || consumer_tag_.empty()) return std::nullopt;
+	// every returned envelope must be passed to ack() once it has been handled
+	AmqpClient::Envelope::ptr_t consume_message(int timeout_ms = 100) {
+    	if (!channel_ || consumer_tag_.empty()) return nullptr;
 
    	 	try {
     	    AmqpClient::Envelope::ptr_t envelope;
     	    if (channel_->BasicConsumeMessage(consumer_tag_, envelope, timeout_ms)) {
-   	         	return envelope->Message()->Body();
+   	         	return envelope;
     	    }
     	} catch (const std::exception& e) {
      	   	std::cerr << "[RabbitMQ] Consume error: " << e.what() << std::endl;
+     	   	channel_.reset();
+     	   	consumer_tag_.clear();
     	}
-    	return std::nullopt;
+    	return nullptr;
+	}
+
+	void ack(const AmqpClient::Envelope::ptr_t& envelope) {
+	    if (!channel_) return;
+	    try {
+	        channel_->BasicAck(envelope);
+	    } catch (const std::exception& e) {
+	        std::cerr << "[RabbitMQ] Ack error: " << e.what() << std::endl;
+	        channel_.reset();
+	        consumer_tag_.clear();
+	    }
+	}
+
+	// hands the message back to the broker for redelivery
+	void reject(const AmqpClient::Envelope::ptr_t& envelope) {
+	    if (!channel_) return;
+	    try {
+	        channel_->BasicReject(envelope, true);
+	    } catch (const std::exception& e) {
+	        std::cerr << "[RabbitMQ] Reject error: " << e.what() << std::endl;
+	        channel_.reset();
+	        consumer_tag_.clear();
+	    }
+	}
+
+	// stops deliveries; prefetched but unacked messages return to the queue when the channel closes
+	void stop_consume() {
+	    if (!channel_ || consumer_tag_.empty()) return;
+	    try {
+	        channel_->BasicCancel(consumer_tag_);
+	    } catch (const std::exception& e) {
+	        std::cerr << "[RabbitMQ] Stop consume error: " << e.what() << std::endl;
+	    }
+	    consumer_tag_.clear();
 	}
 
 	AmqpClient::Channel::ptr_t get_channel() {
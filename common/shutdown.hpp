@@ -0,0 +1,137 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <initializer_list>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace common {
+
+    // Coordinates a graceful stop of the background workers. Workers poll
+    // requested(), sleep through sleep_for() so a stop wakes them at once, and
+    // report() how much work they left behind when the drain deadline passed.
+    // Every worker named in the constructor is expected to report exactly once.
+    class Shutdown {
+    public:
+        Shutdown(std::chrono::milliseconds drain_timeout, std::initializer_list<std::string> workers)
+            : drain_timeout_(drain_timeout) {
+            for (const auto& name : workers) {
+                finished_[name] = false;
+            }
+        }
+
+        void request() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (requested_) return;
+            requested_ = true;
+            requested_at_ = std::chrono::steady_clock::now();
+            std::cout << "[Shutdown] Stop requested, draining workers (deadline "
+                      << drain_timeout_.count() << " ms)" << std::endl;
+            cv_.notify_all();
+        }
+
+        bool requested() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return requested_;
+        }
+
+        bool deadline_passed() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return requested_ && std::chrono::steady_clock::now() - requested_at_ >= drain_timeout_;
+        }
+
+        // false if shutdown was requested before the full duration elapsed
+        bool sleep_for(std::chrono::milliseconds duration) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            return !cv_.wait_for(lock, duration, [this] { return requested_; });
+        }
+
+        // unfinished < 0 means the worker could not tell how much was left
+        void report(const std::string& worker, int unfinished) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_[worker] = true;
+            cv_.notify_all();
+            std::cout << "[Shutdown] " << worker << " stopped after " << drain_ms() << " ms, unfinished: ";
+            if (unfinished < 0) {
+                std::cout << "unknown" << std::endl;
+                unknown_ = true;
+            } else {
+                std::cout << unfinished << std::endl;
+                unfinished_ += unfinished;
+            }
+        }
+
+        bool finished(const std::string& worker) const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = finished_.find(worker);
+            return it != finished_.end() && it->second;
+        }
+
+        // true once the drain deadline plus a short grace for the last iteration has passed;
+        // anything still blocked by then is abandoned instead of waiting for SIGKILL
+        bool give_up_passed() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return requested_ && std::chrono::steady_clock::now() >= give_up_at();
+        }
+
+        void abandon(const std::string& what) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::cerr << "[Shutdown] " << what << " still busy after " << drain_ms()
+                      << " ms, giving up on it" << std::endl;
+            unknown_ = true;
+        }
+
+        // Waits for every worker to report, at most until give_up_passed(). Workers still
+        // running by then (e.g. stuck in a DB call) are reported as unknown and false is returned.
+        bool wait_for_workers() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            bool all = cv_.wait_until(lock, give_up_at(), [this] { return all_finished(); });
+            for (const auto& [name, done] : finished_) {
+                if (!done) {
+                    std::cerr << "[Shutdown] " << name << " still busy after " << drain_ms()
+                              << " ms, giving up on it" << std::endl;
+                    unknown_ = true;
+                }
+            }
+            return all;
+        }
+
+        void summary() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::cout << "[Shutdown] Drain finished in " << drain_ms() << " ms, unfinished work: "
+                      << unfinished_ << (unknown_ ? " (some workers could not report)" : "")
+                      << (drain_ms() > drain_timeout_.count() ? ", deadline exceeded" : "") << std::endl;
+        }
+
+    private:
+        std::chrono::steady_clock::time_point give_up_at() const {
+            return requested_at_ + drain_timeout_ + std::chrono::seconds(1);
+        }
+
+        bool all_finished() const {
+            for (const auto& [name, done] : finished_) {
+                if (!done) return false;
+            }
+            return true;
+        }
+
+        long long drain_ms() const {
+            if (!requested_) return 0;
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - requested_at_).count();
+        }
+
+        std::chrono::milliseconds drain_timeout_;
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        bool requested_ = false;
+        std::chrono::steady_clock::time_point requested_at_;
+        std::map<std::string, bool> finished_;
+        int unfinished_ = 0;
+        bool unknown_ = false;
+    };
+
+} // namespace common
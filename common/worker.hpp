@@ -0,0 +1,189 @@
+#pragma once
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/backoff.hpp"
+#include "common/db_conn.hpp"
+#include "common/health.hpp"
+#include "common/outbox.hpp"
+#include "common/rabbitmq.hpp"
+#include "common/shutdown.hpp"
+
+namespace common {
+
+    // A background worker and the AMQP channel it owns. `name` is its readiness
+    // component, `tag` its log prefix; consumers also subscribe to their queue.
+    struct WorkerChannel {
+        std::string name;
+        std::string tag;
+        RabbitMQ& rabbit;
+        bool consumes;
+    };
+
+    // (Re)opens the worker's channel; false if `cancelled` fired first.
+    inline bool connect_worker(const WorkerChannel& worker, Readiness& readiness,
+                               const std::function<bool()>& cancelled) {
+        if (!worker.rabbit.connect(cancelled)) return false;
+        if (worker.consumes) worker.rabbit.start_consume();
+        if (worker.rabbit.is_connected()) readiness.set_ready(worker.name);
+        return true;
+    }
+
+    // DB and all AMQP channels warm up concurrently, startup waits for the slowest one only.
+    // A stop request cancels the retries; a connect attempt still blocked at the drain
+    // deadline is abandoned the same way drain() abandons a stuck worker.
+    inline void warm_up(Database& db, Readiness& readiness, Shutdown& shutdown,
+                        std::initializer_list<WorkerChannel> workers) {
+        std::function<bool()> cancelled = [&shutdown] { return shutdown.requested(); };
+        std::vector<std::future<void>> tasks;
+        tasks.push_back(std::async(std::launch::async, [&db, &readiness, &cancelled] {
+            if (db.wait_for_connection(cancelled)) readiness.set_ready("database");
+        }));
+        for (const auto& worker : workers) {
+            tasks.push_back(std::async(std::launch::async, [worker, &readiness, &cancelled] {
+                connect_worker(worker, readiness, cancelled);
+            }));
+        }
+        for (auto& task : tasks) {
+            while (task.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready) {
+                if (shutdown.give_up_passed()) {
+                    shutdown.abandon("Warm-up");
+                    shutdown.summary();
+                    std::quick_exit(EXIT_FAILURE);
+                }
+            }
+        }
+    }
+
+    // Runs the HTTP server in the background. Crow stops accepting connections on
+    // SIGINT/SIGTERM, which in turn requests the drain of the background workers.
+    // A server failure (e.g. the port is taken) also drains the workers, then stays in
+    // the future so that get() in main ends the process with a non-zero status.
+    template <typename App>
+    std::future<void> serve(App& app, int port, Shutdown& shutdown) {
+        return std::async(std::launch::async, [&app, port, &shutdown] {
+            try {
+                app.port(port).multithreaded().run();
+            } catch (const std::exception& e) {
+                std::cerr << "[HTTP] Server error: " << e.what() << std::endl;
+                shutdown.request();
+                throw;
+            }
+            shutdown.request();
+        });
+    }
+
+    // Consumes until shutdown is requested. A message taken off the queue is always finished
+    // before the stop flag is checked again. It is acked only if `handle` returned true;
+    // otherwise it goes back to the queue (or is redelivered after a reconnect), which is
+    // safe because both handlers are idempotent.
+    inline void run_consumer(const WorkerChannel& worker, Readiness& readiness, Shutdown& shutdown,
+                             const std::function<bool(const std::string&)>& handle) {
+        std::cout << "[" << worker.tag << "] Starting..." << std::endl;
+        auto cancelled = [&shutdown] { return shutdown.requested(); };
+        // reset only once a message has been handled, not when a channel merely opens
+        Backoff backoff;
+        // -1 (unknown) while the last message went back to the queue or the channel is down
+        int unfinished = 0;
+
+        while (!shutdown.requested()) {
+            // the channel failed (open, subscribe or consume): back off before reopening it,
+            // so a broker that accepts connections but refuses consumers isn't hammered
+            if (!worker.rabbit.is_connected()) {
+                if (!backoff.sleep(cancelled) || !connect_worker(worker, readiness, cancelled)) {
+                    unfinished = -1;
+                    break;
+                }
+            }
+
+            auto envelope = worker.rabbit.consume_message();
+            if (!envelope) continue;
+
+            std::string payload = envelope->Message()->Body();
+            std::cout << "[" << worker.tag << "] Received: " << payload << std::endl;
+
+            bool handled = false;
+            try {
+                handled = handle(payload);
+            } catch (const std::exception& e) {
+                // malformed message: drop it so it doesn't come back forever
+                std::cerr << "[" << worker.tag << "] Dropping malformed message: " << e.what() << std::endl;
+                worker.rabbit.ack(envelope);
+                continue;
+            }
+
+            if (handled) {
+                worker.rabbit.ack(envelope);
+                backoff.reset();
+                unfinished = 0;
+            } else {
+                unfinished = -1;
+                std::cerr << "[" << worker.tag << "] Processing failed, returning message to the queue" << std::endl;
+                worker.rabbit.reject(envelope);
+                backoff.sleep(cancelled);
+            }
+        }
+
+        worker.rabbit.stop_consume();
+        shutdown.report(worker.tag, unfinished);
+    }
+
+    // Relays outbox events until shutdown; after a stop request keeps flushing until the
+    // outbox is empty and `upstream_done` holds, or the drain deadline passes.
+    inline void run_outbox_relay(const WorkerChannel& worker, Readiness& readiness, Shutdown& shutdown,
+                                 const std::function<OutboxResult(const std::function<bool(const std::string&)>&)>& publish_next,
+                                 const std::function<int()>& count_pending,
+                                 const std::function<bool()>& upstream_done = [] { return true; }) {
+        std::cout << "[" << worker.tag << "] Starting..." << std::endl;
+        auto deadline_passed = [&shutdown] { return shutdown.deadline_passed(); };
+        Backoff backoff;
+
+        while (!shutdown.deadline_passed()) {
+            if (!worker.rabbit.is_connected() && !connect_worker(worker, readiness, deadline_passed)) break;
+
+            auto result = publish_next([&worker](const std::string& payload) {
+                std::cout << "[" << worker.tag << "] Publishing event: " << payload << std::endl;
+                return worker.rabbit.publish(payload);
+            });
+
+            if (result == OutboxResult::Published) {
+                backoff.reset();
+            } else if (result == OutboxResult::Failed) {
+                // the event is still pending; retry after the channel is reopened or the DB is back
+                if (!backoff.sleep(deadline_passed)) break;
+            } else if (shutdown.requested()) {
+                if (upstream_done()) break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            } else {
+                shutdown.sleep_for(std::chrono::milliseconds(500));
+            }
+        }
+
+        shutdown.report(worker.tag, count_pending());
+    }
+
+    // Joins the workers if they finish within the drain deadline. Otherwise the summary is
+    // logged and the process exits without them, instead of being SIGKILLed mid-report.
+    inline void drain(Shutdown& shutdown, std::vector<std::thread>& workers) {
+        if (!shutdown.wait_for_workers()) {
+            for (auto& worker : workers) {
+                worker.detach();
+            }
+            shutdown.summary();
+            std::quick_exit(EXIT_FAILURE);
+        }
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        shutdown.summary();
+    }
+
+} // namespace common
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <pqxx/pqxx>
+#include <functional>
 #include <nlohmann/json.hpp>
 #include "common/db_conn.hpp"
 #include "common/dto.hpp"
+#include "common/outbox.hpp"
 
 class OrderRepository {
 public:
@@ -45,37 +47,50 @@ public:
         }
     }
 
-    std::optional<std::string> process_next_outbox_event() {
+    // the row stays locked while `publish` runs and is marked processed only if it succeeded,
+    // so a broker failure leaves the event pending for the next attempt
+    common::OutboxResult publish_next_outbox_event(const std::function<bool(const std::string&)>& publish) {
         try {
             auto conn = db_.get_connection();
-            if (!conn) return std::nullopt;
+            if (!conn) return common::OutboxResult::Failed;
 
             pqxx::work w(*conn);
-
-			// find raw record, lock, update status
             pqxx::result r = w.exec(
-                "UPDATE order_outbox "
-                "SET processed = TRUE "
-                "WHERE id = ("
-                "   SELECT id FROM order_outbox "
-                "   WHERE processed = FALSE "
-                "   ORDER BY id ASC "
-                "   LIMIT 1 "
-                "   FOR UPDATE SKIP LOCKED"
-                ") "
-                "RETURNING payload"
+                "SELECT id, payload FROM order_outbox "
+                "WHERE processed = FALSE "
+                "ORDER BY id ASC "
+                "LIMIT 1 "
+                "FOR UPDATE SKIP LOCKED"
             );
 
-            w.commit();
+            if (r.empty()) return common::OutboxResult::Empty;
+            if (!publish(r[0]["payload"].as<std::string>())) return common::OutboxResult::Failed;
 
-            if (r.empty()) {
-                return std::nullopt;
-            }
+            w.exec_params(
+                "UPDATE order_outbox SET processed = TRUE WHERE id = $1",
+                r[0]["id"].as<int>()
+            );
+            w.commit();
 
-            return r[0][0].as<std::string>();
+            return common::OutboxResult::Published;
         } catch (const std::exception& e) {
             std::cerr << "[Outbox] Error processing event: " << e.what() << std::endl;
-            return std::nullopt;
+            return common::OutboxResult::Failed;
+        }
+    }
+
+	// if return value == -1 => error
+    int count_pending_outbox_events() {
+        try {
+            auto conn = db_.get_connection();
+            if (!conn) return -1;
+
+            pqxx::work w(*conn);
+            pqxx::result r = w.exec("SELECT COUNT(*) FROM order_outbox WHERE processed = FALSE");
+            return r[0][0].as<int>();
+        } catch (const std::exception& e) {
+            std::cerr << "[Outbox] Error counting pending events: " << e.what() << std::endl;
+            return -1;
         }
     }
 
@@ -131,10 +146,11 @@ public:
         }
     }
 
-	void update_order_status(int order_id, const std::string& status) {
+	// false => the status could not be written and the result must be redelivered
+	bool update_order_status(int order_id, const std::string& status) {
         try {
             auto conn = db_.get_connection();
-            if (!conn) return;
+            if (!conn) return false;
 
             pqxx::work w(*conn);
 
@@ -150,8 +166,10 @@ public:
             } else {
                 std::cerr << "[OrderRepo] Order " << order_id << " not found for update!" << std::endl;
             }
+            return true;
         } catch (const std::exception& e) {
             std::cerr << "[OrderRepo] Error updating status: " << e.what() << std::endl;
+            return false;
         }
     }
 
@@ -2,8 +2,10 @@
 #include "common/db_conn.hpp"
 #include "common/rabbitmq.hpp"
 #include "common/dto.hpp"
+#include "common/worker.hpp"
 #include "repository.hpp"
 #include <iostream>
+#include <vector>
 #include <thread>
 #include <chrono>
 
@@ -13,6 +15,9 @@ const std::string RABBIT_HOST = "rabbitmq";
 const std::string QUEUE_INCOMING = "orders_queue";
 const std::string QUEUE_OUTGOING = "payment_results_queue";
 
+// stays under Docker's default 10 s stop grace period
+const auto DRAIN_TIMEOUT = std::chrono::seconds(8);
+
 struct CORSHandler {
     struct context {};
 
@@ -25,68 +30,45 @@ struct CORSHandler {
     }
 };
 
-void run_payment_consumer(PaymentRepository& repo, common::RabbitMQ& rabbit) {
-    std::cout << "[Consumer] Starting..." << std::endl;
-    rabbit.connect();
-    rabbit.start_consume();
-
-    while (true) {
-        try {
-            auto msg_opt = rabbit.consume_message();
-            if (msg_opt.has_value()) {
-                std::string payload = msg_opt.value();
-                std::cout << "[Consumer] Received: " << payload << std::endl;
-
-                auto json = nlohmann::json::parse(payload);
-                common::OrderCreatedEvent event = json.get<common::OrderCreatedEvent>();
-
-                repo.process_payment(event.order_id, event.user_id, event.amount);
-            }
-        } catch (const std::exception& e) {
-            std::cerr << "[Consumer] Error: " << e.what() << std::endl;
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-        }
-    }
+void run_payment_consumer(PaymentRepository& repo, const common::WorkerChannel& worker,
+                          common::Readiness& readiness, common::Shutdown& shutdown) {
+    common::run_consumer(worker, readiness, shutdown, [&repo](const std::string& payload) {
+        auto json = nlohmann::json::parse(payload);
+        common::OrderCreatedEvent event = json.get<common::OrderCreatedEvent>();
+
+        return repo.process_payment(event.order_id, event.user_id, event.amount);
+    });
 }
 
-void run_payment_outbox(PaymentRepository& repo, common::RabbitMQ& rabbit) {
-    std::cout << "[Outbox] Starting..." << std::endl;
-    rabbit.connect();
-
-    while (true) {
-        try {
-            auto payload_opt = repo.process_next_outbox_event();
-            if (payload_opt.has_value()) {
-                std::string payload = payload_opt.value();
-                std::cout << "[Outbox] Sending result: " << payload << std::endl;
-
-                rabbit.publish(payload);
-            } else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
-            }
-        } catch (const std::exception& e) {
-            std::cerr << "[Outbox] Error: " << e.what() << std::endl;
-            std::this_thread::sleep_for(std::chrono::seconds(5));
-        }
-    }
+void run_payment_outbox(PaymentRepository& repo, const common::WorkerChannel& worker,
+                        const common::WorkerChannel& consumer, common::Readiness& readiness,
+                        common::Shutdown& shutdown) {
+    common::run_outbox_relay(worker, readiness, shutdown,
+        [&repo](const std::function<bool(const std::string&)>& publish) {
+            return repo.publish_next_outbox_event(publish);
+        },
+        [&repo] { return repo.count_pending_outbox_events(); },
+        // the consumer may still be committing a payment whose result belongs to this drain
+        [&shutdown, &consumer] { return shutdown.finished(consumer.tag); });
 }
 
 int main() {
     common::Database db(DB_CONN_STR);
-    db.wait_for_connection();
 
     PaymentRepository repo(db);
 
     common::RabbitMQ rabbit_consumer(RABBIT_HOST, QUEUE_INCOMING);
     common::RabbitMQ rabbit_producer(RABBIT_HOST, QUEUE_OUTGOING);
+    common::WorkerChannel consumer{"consumer", "Consumer", rabbit_consumer, true};
+    common::WorkerChannel outbox{"outbox", "Outbox", rabbit_producer, false};
 
-    std::thread t1(run_payment_consumer, std::ref(repo), std::ref(rabbit_consumer));
-    std::thread t2(run_payment_outbox, std::ref(repo), std::ref(rabbit_producer));
-    t1.detach();
-    t2.detach();
+    common::Readiness readiness{"database", consumer.name, outbox.name};
+    common::Shutdown shutdown(DRAIN_TIMEOUT, {consumer.tag, outbox.tag});
 
     crow::App<CORSHandler> app;
 
+    common::add_health_routes(app, readiness);
+
     CROW_ROUTE(app, "/account").methods(crow::HTTPMethod::POST)([&repo](const crow::request& req) {
         auto json = crow::json::load(req.body);
         if (!json || !json.has("user_id")) return crow::response(400);
@@ -115,5 +97,17 @@ int main() {
     });
 
     std::cout << "Starting Payment Service on port 8080..." << std::endl;
-    app.port(8080).multithreaded().run();
+    auto server = common::serve(app, 8080, shutdown);
+
+    common::warm_up(db, readiness, shutdown, {consumer, outbox});
+
+    std::vector<std::thread> workers;
+    workers.emplace_back(run_payment_consumer, std::ref(repo), std::cref(consumer), std::ref(readiness),
+                         std::ref(shutdown));
+    workers.emplace_back(run_payment_outbox, std::ref(repo), std::cref(outbox), std::cref(consumer),
+                         std::ref(readiness), std::ref(shutdown));
+
+    server.wait();
+    common::drain(shutdown, workers);
+    server.get();
 }
\ No newline at end of file
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <pqxx/pqxx>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <nlohmann/json.hpp>
 #include "common/db_conn.hpp"
 #include "common/dto.hpp"
+#include "common/outbox.hpp"
 
 class PaymentRepository {
 public:
@@ -64,10 +66,12 @@ public:
         }
     }
 
-    void process_payment(int order_id, int user_id, int amount) {
+    // false => the message was not processed and must be redelivered;
+    // a duplicate already recorded in payment_inbox counts as processed
+    bool process_payment(int order_id, int user_id, int amount) {
         try {
             auto conn = db_.get_connection();
-            if (!conn) return;
+            if (!conn) return false;
             pqxx::work w(*conn);
             std::string msg_id = "order_" + std::to_string(order_id);
             pqxx::result check = w.exec_params(
@@ -77,7 +81,7 @@ public:
 
             if (check.affected_rows() == 0) {
                 w.commit();
-                return;
+                return true;
             }
 
             std::string status = "FAILED";
@@ -103,37 +107,57 @@ public:
 
             w.commit();
             std::cout << "[PaymentRepo] Processed order " << order_id << ": " << status << std::endl;
-
+            return true;
         } catch (const std::exception& e) {
             std::cerr << "[PaymentRepo] Error processing payment: " << e.what() << std::endl;
+            return false;
         }
     }
 
-    std::optional<std::string> process_next_outbox_event() {
+    // the row stays locked while `publish` runs and is marked processed only if it succeeded,
+    // so a broker failure leaves the event pending for the next attempt
+    common::OutboxResult publish_next_outbox_event(const std::function<bool(const std::string&)>& publish) {
         try {
             auto conn = db_.get_connection();
-            if (!conn) return std::nullopt;
+            if (!conn) return common::OutboxResult::Failed;
+
             pqxx::work w(*conn);
             pqxx::result r = w.exec(
-                "UPDATE payment_outbox "
-                "SET processed = TRUE "
-                "WHERE id = ("
-                "   SELECT id FROM payment_outbox "
-                "   WHERE processed = FALSE "
-                "   ORDER BY id ASC "
-                "   LIMIT 1 "
-                "   FOR UPDATE SKIP LOCKED"
-                ") "
-                "RETURNING payload"
+                "SELECT id, payload FROM payment_outbox "
+                "WHERE processed = FALSE "
+                "ORDER BY id ASC "
+                "LIMIT 1 "
+                "FOR UPDATE SKIP LOCKED"
             );
 
+            if (r.empty()) return common::OutboxResult::Empty;
+            if (!publish(r[0]["payload"].as<std::string>())) return common::OutboxResult::Failed;
+
+            w.exec_params(
+                "UPDATE payment_outbox SET processed = TRUE WHERE id = $1",
+                r[0]["id"].as<int>()
+            );
             w.commit();
 
-            if (r.empty()) return std::nullopt;
-            return r[0][0].as<std::string>();
+            return common::OutboxResult::Published;
         } catch (const std::exception& e) {
             std::cerr << "[PaymentOutbox] Error: " << e.what() << std::endl;
-            return std::nullopt;
+            return common::OutboxResult::Failed;
+        }
+    }
+
+	// if return value == -1 => error
+    int count_pending_outbox_events() {
+        try {
+            auto conn = db_.get_connection();
+            if (!conn) return -1;
+
+            pqxx::work w(*conn);
+            pqxx::result r = w.exec("SELECT COUNT(*) FROM payment_outbox WHERE processed = FALSE");
+            return r[0][0].as<int>();
+        } catch (const std::exception& e) {
+            std::cerr << "[PaymentOutbox] Error counting pending events: " << e.what() << std::endl;
+            return -1;
         }
     }
 